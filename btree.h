@@ -10,6 +10,7 @@
 #ifndef BTREE_H
 #define BTREE_H
 
+#include <algorithm>
 #include <iostream>
 #include <cstddef>
 #include <utility>
@@ -25,6 +26,10 @@
 // what do we do, remember? :)
 template <typename T> class btree;
 template <typename T> std::ostream& operator<<(std::ostream& os, const btree<T>& tree);
+template <typename T> btree<T> set_union(const btree<T>& lhs, const btree<T>& rhs);
+template <typename T> btree<T> set_intersection(const btree<T>& lhs, const btree<T>& rhs);
+template <typename T> btree<T> set_difference(const btree<T>& lhs, const btree<T>& rhs);
+template <typename T> btree<T> set_symmetric_difference(const btree<T>& lhs, const btree<T>& rhs);
 
 template <typename T> 
 class btree {
@@ -97,6 +102,26 @@ class btree {
     * @return a reference to os
     */
     friend std::ostream& operator<< <T>(std::ostream& os, const btree<T>& tree);
+
+    /**
+    * Set operations between two B-Trees.  Both trees are walked in
+    * order at the same time, merging straight into the result, which is
+    * bulk built as a packed tree (see compact) in linear time, instead
+    * of inserting one element at a time.  When
+    * the key ranges of the trees don't overlap, the result is made of
+    * copies of the input trees hung together, without comparing elements.
+    * The result has the maxNodeElems of lhs.
+    *
+    * @param lhs a const reference to a B-Tree object
+    * @param rhs a const reference to a B-Tree object
+    * @return a new B-Tree holding the elements in lhs or rhs (union),
+    *         in both (intersection), in lhs but not rhs (difference),
+    *         or in exactly one of them (symmetric difference)
+    */
+    friend btree<T> set_union <T>(const btree<T>& lhs, const btree<T>& rhs);
+    friend btree<T> set_intersection <T>(const btree<T>& lhs, const btree<T>& rhs);
+    friend btree<T> set_difference <T>(const btree<T>& lhs, const btree<T>& rhs);
+    friend btree<T> set_symmetric_difference <T>(const btree<T>& lhs, const btree<T>& rhs);
 //
   /**
    * The following can go here
@@ -177,6 +202,96 @@ class btree {
     */
     std::pair<iterator, bool> insert(const T& elem);
 
+    /**
+    * Calls f on every element in order without going through the
+    * iterators.  Elements are handed over in runs which are contiguous
+    * in memory, so f is called as f(first, last) with const T* pointers
+    * to the half-open run [first, last).  Runs come in ascending order
+    * and together cover every element exactly once.
+    *
+    * @param f the visitor, f(const T* first, const T* last)
+    */
+    template <typename F>
+    void for_each(F f) const;
+
+    /**
+    * Same as for_each, but only visits the elements in [lo, hi).
+    *
+    * @param lo the smallest element to visit
+    * @param hi the element to stop before
+    * @param f the visitor, f(const T* first, const T* last)
+    */
+    template <typename F>
+    void for_each_in_range(const T& lo, const T& hi, F f) const;
+
+    /**
+    * Same as for_each, but f returns a bool and the traversal stops
+    * as soon as it returns false.
+    *
+    * @param f the visitor, bool f(const T* first, const T* last)
+    * @return true if every element was visited, false if f stopped early
+    */
+    template <typename F>
+    bool for_each_while(F f) const;
+
+    /**
+    * @return the maximum number of elements stored in each node
+    */
+    size_t max_node_elems() const { return size_; }
+
+    /**
+    * Repacks every element into fully filled nodes in one in-order
+    * pass, so the tree gets back the memory wasted on nearly empty
+    * nodes hung off by insert and ends up as shallow as possible.
+    * Existing nodes are reused where possible, spare ones are freed.
+    *
+    * Only leaves may be partially filled (a node with children must
+    * be full), so the fill factor applies to them: each leaf is given
+    * at most max(1, fillFactor * maxNodeElems) elements, leaving room
+    * for later inserts before new nodes are needed.  The one exception
+    * is a tree of at most maxNodeElems elements, which is always kept
+    * in a single node.
+    *
+    * Iterators into the tree are invalidated.
+    *
+    * Every allocation is made before the tree is taken apart, so if
+    * one fails (or copying an element throws) the tree is left as it
+    * was.  Elements are moved if their move constructor is noexcept and
+    * copied otherwise; only a copy throwing while the nodes are relinked
+    * loses the elements, in which case the tree is left empty.
+    *
+    * @param fillFactor target fill of the leaf nodes, in (0, 1],
+    *        values outside are clamped
+    */
+    void compact(double fillFactor = 1.0);
+
+    /**
+    * Moves every element of other into this tree, leaving other empty.
+    * Elements already in this tree are not added twice.  The nodes of
+    * both trees are reused for the packed result, with the same
+    * guarantees as compact if something throws (both trees are left
+    * as they were, or both empty if a copy throws while relinking).  When both trees have
+    * the same maxNodeElems and this one is empty, or their key ranges
+    * don't overlap, the trees are simply taken over or hung together,
+    * so no element is copied or moved at all.
+    *
+    * @param other the B-Tree to take the elements from
+    */
+    void merge(btree<T>& other);
+
+    /**
+    * Replaces the contents of this object with the given values,
+    * building a packed tree (see compact) in linear time instead of
+    * inserting them one by one.
+    *
+    * Gives the same guarantees as compact if something throws.
+    *
+    * @param values the new elements, sorted by operator< and with
+    *        no duplicates
+    * @param fillFactor target fill of the leaf nodes, in (0, 1]
+    */
+    void assign_sorted(std::vector<T> values, double fillFactor = 1.0);
+
   /**
     * Disposes of all internal resources, which includes
     * the disposal of any client objects previously
@@ -201,6 +316,9 @@ private:
         // member function
         Node(const T &value, size_t size,  Node * parent = nullptr):
                 value_(1, value), children_(size + 1, nullptr), parent_{parent}, size_{size} {};
+        // empty node with room for size values, made up front by prepare()
+        explicit Node(size_t size):
+                children_(size + 1, nullptr), parent_{nullptr}, size_{size} { value_.reserve(size); };
         Node(Node &cpy);
 	    ~Node();
         std::pair<unsigned int, bool> priority_insert(const T &);
@@ -214,6 +332,149 @@ private:
     Node * head() const;
     Node * tail() const;
 
+    // hands out the runs of contiguous elements of a tree in order, walking
+    // the nodes with an explicit stack instead of climbing parents
+    class run_cursor {
+    public:
+        // start at the first element not less than *lo, or at the first
+        // element if lo is nullptr, with room for the frames of depth levels
+        run_cursor(Node *root, const T *lo, size_t depth = 0);
+        // the next run [first, last), false once every run was handed out
+        bool next(const T *&first, const T *&last);
+    private:
+        // push the frame of every node from node down to lo's position
+        void descend(Node *node);
+
+        std::vector<std::pair<Node*, size_t>> frames_;
+        const T *lo_;
+    };
+
+    // input iterator over every element of a tree, run by run, so that the
+    // set operations can walk two trees at the same time
+    class flat_iterator {
+    public:
+        // iterator traits
+        typedef std::input_iterator_tag         iterator_category;
+        typedef T                               value_type;
+        typedef const T*                        pointer;
+        typedef const T&                        reference;
+        typedef std::ptrdiff_t                  difference_type;
+
+        // the end iterator, or the first element of the tree at root
+        flat_iterator(): cursor_(nullptr, nullptr), current_{nullptr}, last_{nullptr} {}
+        explicit flat_iterator(Node *root, size_t depth = 0):
+                cursor_(root, nullptr, depth), current_{nullptr}, last_{nullptr} {
+            fetch();
+        }
+        // access method
+        reference operator * () const { return *current_; }
+        pointer operator->() const { return current_; }
+        // ++
+        flat_iterator & operator++() {
+            if (++current_ == last_) {
+                fetch();
+            }
+            return *this;
+        }
+        flat_iterator operator ++ (int) { flat_iterator old(*this); ++(*this); return old; }
+        // compare operator, iterators at the end have no current element
+        bool operator == (const flat_iterator& other) const { return current_ == other.current_; }
+        bool operator != (const flat_iterator& other) const { return !operator == (other); }
+
+    private:
+        // take the next run, or become the end iterator
+        void fetch() {
+            if (!cursor_.next(current_, last_)) {
+                current_ = last_ = nullptr;
+            }
+        }
+
+        run_cursor cursor_;
+        const T *current_;
+        const T *last_;
+    };
+    typedef std::back_insert_iterator<std::vector<T>> flat_inserter;
+
+    // the std set algorithms as function objects, for combine()
+    struct union_op {
+        flat_inserter operator () (flat_iterator first1, flat_iterator last1, flat_iterator first2,
+                                   flat_iterator last2, flat_inserter out) const {
+            return std::set_union(first1, last1, first2, last2, out);
+        }
+    };
+    struct intersection_op {
+        flat_inserter operator () (flat_iterator first1, flat_iterator last1, flat_iterator first2,
+                                   flat_iterator last2, flat_inserter out) const {
+            return std::set_intersection(first1, last1, first2, last2, out);
+        }
+    };
+    struct difference_op {
+        flat_inserter operator () (flat_iterator first1, flat_iterator last1, flat_iterator first2,
+                                   flat_iterator last2, flat_inserter out) const {
+            return std::set_difference(first1, last1, first2, last2, out);
+        }
+    };
+    struct symmetric_difference_op {
+        flat_inserter operator () (flat_iterator first1, flat_iterator last1, flat_iterator first2,
+                                   flat_iterator last2, flat_inserter out) const {
+            return std::set_symmetric_difference(first1, last1, first2, last2, out);
+        }
+    };
+
+    // traversal behind for_each(), for_each_in_range() and for_each_while()
+    // visit runs of the elements in [*lo, *hi), a nullptr bound means
+    // unbounded, return false if f returned false
+    template <typename F>
+    bool visit(const T *lo, const T *hi, F &f) const;
+
+    // used by merge() and the set operations, which way two trees whose key
+    // ranges don't overlap (all of lower is less than all of upper) can be
+    // hung together: 0 if they can't, 1 if upper can hang off the last node
+    // of lower, 2 if lower can hang off the first node of upper
+    static int splice_side(const btree<T> &lower, const btree<T> &upper);
+    // hang the trees together as told by splice_side(), return the new root,
+    // both trees are left empty
+    static Node * splice(btree<T> &lower, btree<T> &upper, int side);
+    // true if the key ranges of the trees don't overlap, or one is empty
+    static bool disjoint(const btree<T> &lhs, const btree<T> &rhs);
+    // used by the set operations, the general case: walk both trees at the
+    // same time, combining them with op (one of the *_op above) straight
+    // into the values of the result, then bulk build it
+    template <typename Op>
+    static btree<T> combine(const btree<T> &lhs, const btree<T> &rhs, Op op);
+
+    // used by compact(), merge() and assign_sorted(), which all first make
+    // every allocation, then take the elements out and only then relink the
+    // nodes, so that a bad_alloc leaves the trees as they were
+
+    // the number of values a leaf of a packed tree holds for fillFactor
+    size_t leaf_size(double fillFactor) const;
+    // the largest number of values a child of a packed node holding count
+    // values can take
+    size_t child_capacity(size_t count, size_t leaf) const;
+    // the number of values child i of a packed node holding count values
+    // takes, child being child_capacity(count, leaf)
+    size_t child_take(size_t count, size_t child, size_t leaf, size_t i) const;
+    // the number of nodes a packed tree of count values needs
+    size_t packed_nodes(size_t count, size_t leaf) const;
+    // the number of levels of a subtree
+    static size_t height(Node *node);
+    // put every node of a subtree into 'nodes', without changing it
+    static void gather(Node *node, std::vector<Node*> &nodes);
+    // move (or copy, if T's move may throw) every value of a subtree into
+    // 'values' (inorder sequency), which must have room for them
+    static void extract(Node *node, std::vector<T> &values);
+    // make sure 'pool' has 'needed' nodes with room for size_ values,
+    // allocating the missing ones, nothing is changed if this throws
+    void prepare(std::vector<Node*> &pool, size_t needed);
+    // replace the tree by a packed tree of the sorted values, reusing the
+    // nodes of a prepared pool, which must hold every node of the old tree(s)
+    void pack(std::vector<T> &values, size_t leaf, std::vector<Node*> &pool);
+    // used by pack(), build a packed subtree from sorted values [first, last)
+    // taking nodes from pool[next] on, no allocation is made
+    Node * rebuild(typename std::vector<T>::iterator first, typename std::vector<T>::iterator last,
+                   size_t leaf, Node *parent, std::vector<Node*> &pool, size_t &next);
+
 };
 
 #include "btree.tem"
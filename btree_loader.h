@@ -0,0 +1,132 @@
+/**
+ * Loads a text file of one word per line into a btree without
+ * allocating a string per line.  The file is memory-mapped, lines
+ * are found with a memchr scan and the tree stores line_view keys
+ * which point straight into the mapping.  The mapping lives as long
+ * as the tree (or any copy of it) that was built from it.
+ */
+
+#ifndef BTREE_LOADER_H
+#define BTREE_LOADER_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "btree.h"
+
+/**
+ * A non-owning view of a line of text: a pointer and a length.
+ * Ordered like std::string, so a btree of views iterates in the
+ * same order as a btree of the equivalent strings.
+ */
+class line_view {
+ public:
+    line_view(): data_{nullptr}, size_{0} {}
+    line_view(const char *data, size_t size): data_{data}, size_{size} {}
+
+    const char * data() const { return data_; }
+    size_t size() const { return size_; }
+    // copy the line into an owned string
+    std::string str() const { return std::string(data_, size_); }
+
+    friend bool operator < (const line_view &lhs, const line_view &rhs) { return compare(lhs, rhs) < 0; }
+    friend bool operator > (const line_view &lhs, const line_view &rhs) { return compare(lhs, rhs) > 0; }
+    friend bool operator == (const line_view &lhs, const line_view &rhs) { return compare(lhs, rhs) == 0; }
+    friend bool operator != (const line_view &lhs, const line_view &rhs) { return compare(lhs, rhs) != 0; }
+    friend std::ostream& operator << (std::ostream &os, const line_view &line) {
+        return os.write(line.data_, line.size_);
+    }
+
+ private:
+    static int compare(const line_view &lhs, const line_view &rhs);
+
+    const char *data_;
+    size_t size_;
+};
+
+/**
+ * A read-only memory mapping of a whole file, unmapped on destruction.
+ * Not copyable, share it through a shared_ptr instead.
+ */
+class mapped_file {
+ public:
+    /**
+    * Maps the file at path.
+    *
+    * @param path the file to map
+    * @throw std::system_error if the file can't be opened or mapped
+    */
+    explicit mapped_file(const std::string &path);
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator = (const mapped_file&) = delete;
+    ~mapped_file();
+
+    const char * data() const { return data_; }
+    size_t size() const { return size_; }
+
+ private:
+    const char *data_;
+    size_t size_;
+};
+
+/**
+ * A btree of line_view keys together with the mapping they point into.
+ * Only the read-only part of the btree is exposed, as views into other
+ * memory would not be kept alive by the mapping.  Copies share the
+ * mapping, so every copy stays valid.
+ */
+class line_btree {
+ public:
+    typedef btree<line_view>::iterator iterator;
+    typedef btree<line_view>::const_iterator const_iterator;
+
+    iterator begin() const { return tree_.begin(); }
+    iterator end() const { return tree_.end(); }
+    const_iterator find(const line_view& elem) const { return tree_.find(elem); }
+
+    // see btree::for_each, btree::for_each_in_range and btree::for_each_while
+    template <typename F>
+    void for_each(F f) const { tree_.for_each(f); }
+    template <typename F>
+    void for_each_in_range(const line_view& lo, const line_view& hi, F f) const { tree_.for_each_in_range(lo, hi, f); }
+    template <typename F>
+    bool for_each_while(F f) const { return tree_.for_each_while(f); }
+
+    /**
+    * Builds a tree holding owned copies of every line, for when the
+    * keys must outlive the mapping.
+    *
+    * @return a packed btree of std::string with the same elements
+    */
+    btree<std::string> materialise() const;
+
+ private:
+    friend line_btree load_lines(const std::string &path, size_t maxNodeElems);
+
+    line_btree(std::shared_ptr<const mapped_file> file, btree<line_view> tree):
+            file_(std::move(file)), tree_(std::move(tree)) {}
+
+    // declared first so the tree goes before the mapping it points into
+    std::shared_ptr<const mapped_file> file_;
+    btree<line_view> tree_;
+};
+
+/**
+ * Loads every line of the file at path into a packed btree.  Line
+ * endings ("\n" or "\r\n") are not part of the keys, a final line
+ * without a newline is still loaded, blank lines are skipped and
+ * duplicate lines are stored once.
+ *
+ * @param path the text file to load
+ * @param maxNodeElems the maximum number of elements in each node
+ * @return the tree, which owns the mapping of the file
+ * @throw std::system_error if the file can't be opened or mapped
+ */
+line_btree load_lines(const std::string &path, size_t maxNodeElems = 40);
+
+#include "btree_loader.tem"
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ * A sharded_btree splits its elements by key range over a number of
+ * independent btrees (shards), so that a large unsorted input can be
+ * built with one thread per shard (up to the number of hardware threads).  The splitters between the shards
+ * are chosen from a sample of the input.  Every element of shard i is
+ * less than every element of shard i + 1, so walking the shards one
+ * after the other visits all elements in order.
+ */
+
+#ifndef SHARDED_BTREE_H
+#define SHARDED_BTREE_H
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "btree.h"
+
+template <typename T> class sharded_btree;
+
+// iterator over every shard in order, the shards' own iterators
+// are concatenated, skipping empty shards
+template <typename T>
+class sharded_btree_iterator {
+public:
+    // iterator traits
+    typedef std::forward_iterator_tag       iterator_category;
+    typedef T                               value_type;
+    typedef T*                              pointer;
+    typedef T&                              reference;
+    typedef std::ptrdiff_t                  difference_type;
+
+    // constructor
+    sharded_btree_iterator(const std::vector<btree<T>> *shards = nullptr, size_t shard = 0,
+                           typename btree<T>::iterator current = typename btree<T>::iterator()):
+            shards_{shards}, shard_{shard}, current_(current) { skip(); }
+    // access method
+    reference operator * () const { return *current_; }
+    pointer operator->() const { return &*current_; }
+    // ++
+    sharded_btree_iterator & operator++() { ++current_; skip(); return *this; }
+    void operator ++ (int) { ++(*this); }
+    // compare operator
+    bool operator == (const sharded_btree_iterator& other) const {
+        return shard_ == other.shard_ && current_ == other.current_;
+    }
+    bool operator != (const sharded_btree_iterator& other) const { return !operator == (other); }
+
+private:
+    // if current_ is at the end of its shard, go to the first element of
+    // the next non-empty shard, or to end() if there is none
+    void skip();
+
+    const std::vector<btree<T>> *shards_;
+    size_t shard_;
+    typename btree<T>::iterator current_;
+};
+
+template <typename T>
+class sharded_btree {
+public:
+    typedef sharded_btree_iterator<T> iterator;
+
+    /**
+    * Builds a sharded tree holding every element of values.  The
+    * splitters are chosen from a sample of values, then values are
+    * partitioned and every shard is built on its own thread.  There
+    * are never more threads than hardware threads: with more shards
+    * than that, each thread builds several shards.
+    *
+    * @param values the elements, in any order and possibly repeated
+    * @param shards the number of shards, 0 for one per hardware
+    *        thread, capped at the number of values
+    * @param maxNodeElems the maximum number of elements stored in
+    *        each node of the shards
+    */
+    sharded_btree(const std::vector<T>& values, size_t shards = 0, size_t maxNodeElems = 40);
+
+    iterator begin() const { return iterator(&shards_, 0, shards_.front().begin()); }
+    iterator end() const { return iterator(&shards_, shards_.size()); }
+
+    /**
+    * Looks up elem in the only shard whose range can hold it.
+    *
+    * @param elem the element to match
+    * @return an iterator to the matching element, or end()
+    */
+    iterator find(const T& elem) const;
+
+    /**
+    * Inserts elem into the shard whose range holds it.  Not thread safe.
+    *
+    * @param elem the element to be inserted
+    * @return the iterator to the matching element and whether it was added
+    */
+    std::pair<iterator, bool> insert(const T& elem);
+
+    /**
+    * Stitches the shards into a single packed btree, in linear time.
+    *
+    * @return a btree holding every element of every shard
+    */
+    btree<T> stitch() const;
+
+    size_t shard_count() const { return shards_.size(); }
+
+private:
+    // index of the shard whose range holds elem
+    size_t route(const T& elem) const;
+
+    std::vector<btree<T>> shards_;
+    // shard i holds elements in [splitters_[i - 1], splitters_[i])
+    std::vector<T> splitters_;
+    size_t maxNodeElems_;
+};
+
+#include "sharded_btree.tem"
+
+#endif
@@ -0,0 +1,46 @@
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+#include "btree.h"
+
+void print(const btree<int> &b) {
+  std::copy(b.begin(), b.end(), std::ostream_iterator<int>(std::cout, " "));
+  std::cout << std::endl;
+  std::cout << b << std::endl;
+}
+
+int main(void) {
+  btree<int> b(3);
+
+  // sorted inserts hang a new node off every full node
+  for (int i = 1; i <= 20; ++i)
+    b.insert(i);
+  print(b);
+
+  b.compact();
+  print(b);
+
+  // the tree still works after compaction
+  std::cout << (b.find(7) != b.end()) << (b.find(21) != b.end()) << std::endl;
+  b.insert(0);
+  b.insert(21);
+  print(b);
+
+  // leave room in the leaves for later inserts
+  b.compact(0.5);
+  print(b);
+
+  // the rightmost leaves keep their room too
+  btree<int> ascending(3);
+  for (int i = 0; i < 20; ++i)
+    ascending.insert(i);
+  ascending.compact(0.34);
+  print(ascending);
+
+  btree<int> empty;
+  empty.compact();
+  std::cout << empty << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,38 @@
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "btree_loader.h"
+
+int main(void) {
+  line_btree *words = new line_btree(load_lines("twl.txt", 40));
+
+  // first few words in sorted order
+  int count = 0;
+  for (auto iter = words->begin(); iter != words->end() && count < 5; ++iter, ++count)
+    std::cout << *iter << std::endl;
+
+  std::string word("ZYZZYVA");
+  line_view key(word.data(), word.size());
+  std::cout << word << (words->find(key) != words->end() ? " found" : " not found") << std::endl;
+
+  // owned keys and copies outlive the original tree
+  btree<std::string> owned = words->materialise();
+  line_btree copy = *words;
+  delete words;
+
+  std::cout << std::distance(owned.begin(), owned.end()) << " "
+            << std::distance(copy.begin(), copy.end()) << std::endl;
+  std::cout << (std::equal(owned.begin(), owned.end(), copy.begin(),
+                           [](const std::string &s, const line_view &l) { return s == l.str(); })
+                ? "same" : "different") << std::endl;
+
+  try {
+    load_lines("no_such_file.txt");
+  } catch (const std::system_error &) {
+    std::cout << "no_such_file.txt can't be loaded" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,44 @@
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "btree.h"
+
+int main(void) {
+  btree<int> b(4);
+  for (int i = 1; i <= 100; ++i)
+    b.insert((i * 37) % 101);
+
+  // sum and count-if over every element
+  long sum = 0;
+  long even = 0;
+  b.for_each([&](const int *first, const int *last) {
+    for (; first != last; ++first) {
+      sum += *first;
+      even += (*first % 2 == 0);
+    }
+  });
+  std::cout << sum << " " << even << std::endl;
+
+  // export of a range
+  std::vector<int> range;
+  b.for_each_in_range(40, 50, [&](const int *first, const int *last) {
+    range.insert(range.end(), first, last);
+  });
+  for (int value : range)
+    std::cout << value << " ";
+  std::cout << std::endl;
+
+  // stop at the first element greater than 90
+  int found = 0;
+  bool all = b.for_each_while([&](const int *first, const int *last) {
+    const int *match = std::find_if(first, last, [](int value) { return value > 90; });
+    if (match == last)
+      return true;
+    found = *match;
+    return false;
+  });
+  std::cout << found << " " << all << std::endl;
+
+  return 0;
+}
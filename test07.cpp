@@ -0,0 +1,42 @@
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <vector>
+
+#include "sharded_btree.h"
+
+int main(void) {
+  // unsorted input with repeats
+  std::vector<long> values;
+  for (long i = 0; i < 20000; ++i)
+    values.push_back((i * 7919) % 10007);
+
+  sharded_btree<long> tree(values, 4, 16);
+  std::set<long> expected(values.begin(), values.end());
+
+  std::cout << tree.shard_count() << " shards" << std::endl;
+  std::cout << (std::equal(expected.begin(), expected.end(), tree.begin()) ? "ordered" : "not ordered")
+            << std::endl;
+  std::cout << std::distance(tree.begin(), tree.end()) << " elements" << std::endl;
+
+  std::cout << *tree.find(5000) << " " << (tree.find(20000) == tree.end()) << std::endl;
+  std::cout << tree.insert(20000).second << tree.insert(5000).second << std::endl;
+
+  btree<long> whole = tree.stitch();
+  std::cout << (std::equal(tree.begin(), tree.end(), whole.begin()) ? "stitched" : "not stitched")
+            << std::endl;
+
+  // far more shards than cores, the threads are shared between them
+  sharded_btree<long> many(values, 100000, 5);
+  std::cout << many.shard_count() << " shards" << std::endl;
+  std::cout << (std::equal(expected.begin(), expected.end(), many.begin()) ? "ordered" : "not ordered")
+            << std::endl;
+  std::cout << *many.find(777) << std::endl;
+
+  // an empty input gives a single empty shard
+  sharded_btree<long> empty(std::vector<long>(), 4);
+  std::cout << empty.shard_count() << " " << (empty.begin() == empty.end()) << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,50 @@
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+#include "btree.h"
+
+void print(const btree<int> &b) {
+  std::copy(b.begin(), b.end(), std::ostream_iterator<int>(std::cout, " "));
+  std::cout << std::endl;
+}
+
+int main(void) {
+  btree<int> odd(3), low(3);
+  for (int i = 1; i <= 15; i += 2)
+    odd.insert(i);
+  for (int i = 1; i <= 8; ++i)
+    low.insert(i);
+
+  print(set_union(odd, low));
+  print(set_intersection(odd, low));
+  print(set_difference(odd, low));
+  print(set_symmetric_difference(odd, low));
+
+  // ranges that don't overlap are hung together
+  btree<int> high(3);
+  for (int i = 20; i <= 27; ++i)
+    high.insert(i);
+  low.compact();
+  btree<int> joined = set_union(high, low);
+  print(joined);
+  std::cout << joined << std::endl;
+  print(set_intersection(low, high));
+  print(set_difference(low, high));
+
+  // merge empties the other tree
+  low.merge(high);
+  print(low);
+  std::cout << (high.begin() == high.end()) << std::endl;
+  odd.merge(low);
+  print(odd);
+  std::cout << *odd.find(21) << std::endl;
+
+  // merging into an empty tree takes the other one over
+  btree<int> none(3);
+  none.merge(odd);
+  print(none);
+  std::cout << (odd.begin() == odd.end()) << std::endl;
+
+  return 0;
+}